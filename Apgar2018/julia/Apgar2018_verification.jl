@@ -56,9 +56,13 @@ latexify(ode)
 prob = ODEProblem(ode, initLNP, tspan, pars);
 sol = solve(prob, Tsit5(), reltol = 1e-2, progress=true, progress_steps=60, saveat = 300);
 
-# read in simulation result from mrgsolve
-using CSV, DataFrames;
-mrgsolveresult = CSV.read("../data/ForJuliaValidation.csv", DataFrame);
+# read in simulation result from mrgsolve (written by RunModel2.r to shared memory; see utils/shmbuffer.R)
+# Arrow.Table memory maps the buffer; the columns are views of the shared memory, not copies
+# the buffer does not survive a reboot; without it, the saved mrgsolve output in data/ is read instead
+using Arrow, CSV, DataFrames;
+shmdir = get(ENV, "MRG_SHM_DIR", isdir("/dev/shm") ? "/dev/shm" : get(ENV, "TMPDIR", "/tmp"));
+shmfile = joinpath(shmdir, "ForJuliaValidation.arrow");
+mrgsolveresult = isfile(shmfile) ? Arrow.Table(shmfile) : CSV.read("../data/ForJuliaValidation.csv", DataFrame);
 
 # plot results
 plotLNP = plot(sol.t/3600, [sol.u[i][1] for i in 1:length(sol.t)], label="LNP, central compartment",  linewidth = 2);
@@ -5,6 +5,8 @@ setwd(dirname(rstudioapi::getSourceEditorContext()$path))
 library(tidyverse)
 library(mrgsolve)
 
+source("../../utils/shmbuffer.R")
+
 # list time points to save 
 
 savetime <- seq(from = 0, to = 72, by = 1) * 3600
@@ -16,5 +18,5 @@ simul <- mod %>% mrgsim() %>% as.tibble() %>%
          mutate(hour = time/3600) %>%
          select(-c(ID, PlasmaDrug, mRNA, time))
 
-# save the result
-write.csv(simul, file = "../data/ForJuliaValidation.csv", row.names = FALSE)
\ No newline at end of file
+# hand the result to Apgar2018_verification.jl through shared memory (see utils/shmbuffer.R)
+shm_write(simul, "ForJuliaValidation", meta = list(model = "model2"))
\ No newline at end of file
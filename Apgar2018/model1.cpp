@@ -85,7 +85,8 @@ running_0 = init_running;
 // dosing regiment
 double dose = dosing * animal_weight / moleweight_LNP; // convert dose to nmol; mass
 
-LNP_0 = dose; 
+// set dosing = 0 to dose through events instead (see utils/regimen.R)
+if(dose > 0) LNP_0 = dose; 
 
 [ODE]
 
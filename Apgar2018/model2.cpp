@@ -59,7 +59,8 @@ moleweight_LNP = 1 // estimation based on https://pubs.acs.org/doi/10.1021/mp500
 // dosing regiment
 double dose = dosing * animal_weight / moleweight_LNP; // convert dose to nmol; mass
 
-LNP_0 = dose; 
+// set dosing = 0 to dose through events instead (see utils/regimen.R)
+if(dose > 0) LNP_0 = dose; 
 
 [ODE]
 
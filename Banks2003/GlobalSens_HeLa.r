@@ -81,9 +81,24 @@ sobolx <- list(S = pglobal$S , T = pglobal$T)
 saveRDS(sobolx, file = "data/Sobol_nucleusPlasmid.rds")
 
 
+##------------------------- Polynomial chaos -------------------------##
+# the same indices from a sparse polynomial chaos expansion fitted to a few hundred native solves (utils/pce.R);
+# saved in the layout of sobol2007; set sobol_file below to data/Sobol_nucleusPlasmid_pce.rds to plot these instead
+source("../utils/smallsweep.R")
+source("../utils/pce.R")
+
+sm <- small_model(mod, "banks2003.cpp")
+nPlasmid_auc <- function(sim) sim %>% group_by(ID) %>% summarise(pexp = auc_partial(time, N)) %>% pull(pexp)
+
+pce <- sim_pce(sm, pce_inputs(mod, set2, factor = c(0.1, 10)), n = 400, qoi = nPlasmid_auc, degree = 4)
+print(pce)
+pce_save(pce, "data/pce_nucleusPlasmid.rds")
+saveRDS(pce_sobol(pce, nboot = simulationboot), file = "data/Sobol_nucleusPlasmid_pce.rds")
+
 ##------------------------- Visualization -------------------------##
 
-x <- readRDS("data/Sobol_nucleusPlasmid.rds")
+sobol_file <- "data/Sobol_nucleusPlasmid.rds" # or "data/Sobol_nucleusPlasmid_pce.rds" (polynomial chaos)
+x <- readRDS(sobol_file)
 
 set2 <- c('k1', 'k2', 'k3','k4')
 
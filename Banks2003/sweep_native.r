@@ -0,0 +1,51 @@
+# Parameter sweep of the HeLa model without per-simulation allocation (utils/smallsweep.R), compared with mrgsim
+rm(list = ls())
+setwd(dirname(rstudioapi::getSourceEditorContext()$path)) # set the working directory at current folder
+
+# load required packages
+library(tidyverse)
+library(mrgsolve)
+library(PKPDmisc)
+source("../utils/smallsweep.R")
+
+mod <- mread("banks2003") %>% init(M = 2.41e11)
+sm <- small_model(mod, "banks2003.cpp")
+
+# log-uniform samples of the rate constants (0.1 to 10 fold), as in GlobalSens_HeLa.r
+set.seed(88771)
+n <- 20000
+idata <- as.data.frame(lapply(param(mod)[c("k1", "k2", "k3", "k4")], function(k) k * exp(runif(n, log(0.1), log(10)))))
+idata$ID <- seq_len(n)
+
+##---- Timing ----##
+t_mrgsim <- system.time(sim_mrgsim <- mod %>% idata_set(idata) %>% mrgsim(obsonly = TRUE) %>% as.data.frame())
+t_small <- system.time(sim_small <- small_sweep(sm, idata))
+rbind(mrgsim = t_mrgsim, small_sweep = t_small)[, "elapsed"]
+
+# same nuclear plasmid exposure as mrgsim (different solver, same tolerances)
+auc <- function(sim) sim %>% group_by(ID) %>% summarise(pexp = auc_partial(time, N)) %>% pull(pexp)
+summary(abs(auc(sim_small)/ auc(sim_mrgsim) - 1))
+
+##---- Allocations ----##
+# blocks taken from the system after the first simulation of each thread; both the stack path and the arena path
+# should not allocate per simulation
+for(fixed in c(TRUE, FALSE)){
+  out <- small_sweep(sm, idata, fixed = fixed, nthreads = 2)
+  message("fixed = ", fixed, ": ", attr(out, "system_allocs"), " arena blocks, ", attr(out, "steady_allocs"),
+          " after the first simulation")
+  stopifnot(attr(out, "steady_allocs") == 0)
+}
+
+##---- Single-precision screening ----##
+# float sweep at 1e-3 relative tolerance, 2% double-precision shadows, flagged simulations refined in double
+t_screen <- system.time(sim_screen <- small_screen(sm, idata, rtol = 1e-3))
+t_double <- system.time(sim_double <- small_sweep(sm, idata, rtol = 1e-3, atol = 1e-9))
+rbind(double = t_double, screen = t_screen)[, "elapsed"]
+table(attr(sim_screen, "lanes")$reason)
+summary(attr(sim_screen, "shadow_error"))
+
+# the ranking of the parameter sets by nuclear plasmid exposure is what the screen is for
+cor(auc(sim_screen), auc(sim_double), method = "spearman")
+
+# models with Avogadro-sized conversions stay in double
+small_scale(small_model(mread("mihaila2017_v3", project = "../Mihaila2017"), "../Mihaila2017/mihaila2017_v3.cpp"))
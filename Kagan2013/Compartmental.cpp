@@ -45,9 +45,11 @@ L_kel = 8.65e-2 // unit: h-1
 double Vc = V_c * wt; // central volume, nonliposomal, unit: L-1
 double L_Vc = L_V_c * wt; // central volume, liposomal, unit: L-1
 
-// initial value of the drug
-A_LIP_c_0 = dose * wt * (1-FR/100) ; 
-A_c_0 = dose * wt * FR/100;
+// initial value of the drug; set dose = 0 to dose through events instead (see utils/regimen.R)
+if(dose > 0) {
+  A_LIP_c_0 = dose * wt * (1-FR/100) ; 
+  A_c_0 = dose * wt * FR/100;
+}
 
 [ODE]
 
@@ -111,8 +111,8 @@ dose = 20 // unit: mg.kg-1; rat data
 
 [MAIN]
 
-// initial value of the drug
-A_pl_0 = dose * wt ; 
+// initial value of the drug; set dose = 0 to dose through events instead (see utils/regimen.R)
+if(dose > 0) A_pl_0 = dose * wt ; 
 
 
 // flow through organs
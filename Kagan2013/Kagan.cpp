@@ -3,6 +3,13 @@
 Model from Kagan et al., 2013
 https://pubmed.ncbi.nlm.nih.gov/23793994/
 
+[INCLUDE]
+../utils/mrgprof.h
+
+[GLOBAL]
+// per-block profiling; empty unless compiled with -DMRG_PROFILE (see utils/profile.R)
+MRG_PROF_MODEL("Kagan");
+
 [SET]
 
 delta = 0.1, end = 24
@@ -160,10 +167,13 @@ rel = 0.0035 // unit: h-1
 dose = 20 // unit: mg.kg-1; rat data
 
 [MAIN]
+MRG_PROF_MAIN;
 
-// initial value of the drug
-A_pl_LIP_0 = dose * wt * (1-FR/100) ; 
-A_pl_0 = dose * wt * FR/100 ; 
+// initial value of the drug; set dose = 0 to dose through events instead (see utils/regimen.R)
+if(dose > 0) {
+  A_pl_LIP_0 = dose * wt * (1-FR/100) ; 
+  A_pl_0 = dose * wt * FR/100 ; 
+}
 
 
 // flow through organs
@@ -222,6 +232,7 @@ double V_rm_vas = wt * v_frac_rm * vs_frac_rm;
 double V_rm_exv = wt * v_frac_rm * (1 - vs_frac_rm);
 
 [ODE]
+MRG_PROF_ODE;
 // list of nonliposomal concentrations
 double C_pl = A_pl/ V_pl;
 double C_gi = A_gi/ V_gi;
@@ -336,6 +347,7 @@ dxdt_A_rm_exv_LIP = UPrm*C_rm_vas_LIP - rel*C_rm_exv_LIP*V_rm_exv;
 dxdt_A_clear = CL_li*f_u_pl*C_li/Kpli + CL_kd*f_u_pl*C_kd_vas + CL_rm*f_u_rm*C_rm_exv;
 
 [TABLE]
+MRG_PROF_TABLE;
 
 // check for mass balance
 capture totaldrug = A_pl + A_gi + A_ht  +  
@@ -0,0 +1,121 @@
+[PROB]
+
+Generated from varga2005.cpp by log_model() (utils/positivity.R): ComplexBound_NPC, ComplexBound_nuclear, Complex_nuclear, Plasmid_nuclear, PlasmidBound_NPC, PlasmidBound_nuclear are integrated in log space.
+
+This model file creates the model published in Varga et al., 2005
+https://www.nature.com/articles/3302495
+
+Note this implementation does not track vector dynamics. In addition, the tracking on degredaded plasmid is adjusted to reflect the biology. 
+
+Furthermore, extracellular complex (i.e. vector + plasmid) is modeled as a dummy variable to track complex internalization.
+
+[SET]
+
+delta = 10, end = 60*24*3 // time in minutes
+
+[INIT]
+Complex_extracellular = 0
+// complex stands for rAAV (or lipid packages) + plasmid
+Complex_internal = 0
+Complex_cytoplasmic = 0
+ComplexBound_cytoplasmic = 0
+log_ComplexBound_NPC = -6.90775527898214 // log(ComplexBound_NPC + 0.001)
+log_ComplexBound_nuclear = -6.90775527898214 // log(ComplexBound_nuclear + 0.001)
+log_Complex_nuclear = -6.90775527898214 // log(Complex_nuclear + 0.001)
+
+// plasmid is the trans gene
+log_Plasmid_nuclear = -6.90775527898214 // log(Plasmid_nuclear + 0.001)
+Plasmid_cytoplasmic = 0
+PlasmidBound_cytoplasmic = 0
+log_PlasmidBound_NPC = -6.90775527898214 // log(PlasmidBound_NPC + 0.001)
+log_PlasmidBound_nuclear = -6.90775527898214 // log(PlasmidBound_nuclear + 0.001)
+
+Protein = 0
+X_plasmid = 0 // plasmid that has been degraded
+
+[PARAM]
+//--- parameters that are vector specific ---//
+// (default, Ad5)
+k_bind_uptake = 6e-3
+k_deg_vesicle = 2e-2 // lysosomal degredaion
+k_escape = 1.6e-2 // endosomal escape; unit min-1
+k_bind_vector = 1e-1
+k_unpack = 1e-2 // vector unpacking; unit min-1
+
+//--- parameters that holds throughout ---//
+// inherited parameters
+k_bind_plasmid = 2e-3 // formation of nuclear import protein bound vector; unit min-1
+k_degredation = 5e-3 // plasmid degredation; unit min-1
+k_NPC = 1e3 // nuclear pore association; unit min-1
+k_in = 3e-3 // nuclear pore import; unit min-1
+k_dissociation = 1e-3 // import protein dissociation within the nucleus; unit min-1
+
+//--- other parameters ---//
+k_protein = 1e-2 // protein production; unit min-1
+
+[ODE]
+// amounts of the log compartments (utils/positivity.R)
+double ComplexBound_NPC = exp(log_ComplexBound_NPC) - 0.001; if(ComplexBound_NPC < 0) ComplexBound_NPC = 0;
+double ComplexBound_nuclear = exp(log_ComplexBound_nuclear) - 0.001; if(ComplexBound_nuclear < 0) ComplexBound_nuclear = 0;
+double Complex_nuclear = exp(log_Complex_nuclear) - 0.001; if(Complex_nuclear < 0) Complex_nuclear = 0;
+double Plasmid_nuclear = exp(log_Plasmid_nuclear) - 0.001; if(Plasmid_nuclear < 0) Plasmid_nuclear = 0;
+double PlasmidBound_NPC = exp(log_PlasmidBound_NPC) - 0.001; if(PlasmidBound_NPC < 0) PlasmidBound_NPC = 0;
+double PlasmidBound_nuclear = exp(log_PlasmidBound_nuclear) - 0.001; if(PlasmidBound_nuclear < 0) PlasmidBound_nuclear = 0;
+
+
+dxdt_Complex_extracellular = -k_bind_uptake*Complex_extracellular; 
+
+// cytoplasmic
+dxdt_Complex_internal = k_bind_uptake*Complex_extracellular - k_escape*Complex_internal - k_deg_vesicle*Complex_internal; 
+
+dxdt_Complex_cytoplasmic = k_escape*Complex_internal - k_bind_vector*Complex_cytoplasmic - k_unpack*Complex_cytoplasmic;
+
+dxdt_Plasmid_cytoplasmic = k_unpack*Complex_cytoplasmic - k_bind_plasmid*Plasmid_cytoplasmic - k_degredation*Plasmid_cytoplasmic;
+
+dxdt_PlasmidBound_cytoplasmic = k_bind_plasmid*Plasmid_cytoplasmic - k_NPC*PlasmidBound_cytoplasmic;
+
+dxdt_ComplexBound_cytoplasmic = k_bind_vector*Complex_cytoplasmic - k_NPC*ComplexBound_cytoplasmic; 
+
+// NPC-related status
+
+dxdt_log_ComplexBound_NPC = (k_NPC*ComplexBound_cytoplasmic - k_in*ComplexBound_NPC)/ exp(log_ComplexBound_NPC); 
+
+dxdt_log_PlasmidBound_NPC = (k_NPC*PlasmidBound_cytoplasmic - k_in*PlasmidBound_NPC)/ exp(log_PlasmidBound_NPC);
+
+// nuclear
+
+dxdt_log_ComplexBound_nuclear = (k_in*ComplexBound_NPC - k_dissociation*ComplexBound_nuclear)/ exp(log_ComplexBound_nuclear);
+
+dxdt_log_PlasmidBound_nuclear = (k_in*PlasmidBound_NPC - k_dissociation*PlasmidBound_nuclear)/ exp(log_PlasmidBound_nuclear);
+
+dxdt_log_Complex_nuclear = (k_dissociation*ComplexBound_nuclear - k_unpack*Complex_nuclear)/ exp(log_Complex_nuclear);
+
+dxdt_log_Plasmid_nuclear = (k_unpack*Complex_nuclear + k_dissociation*PlasmidBound_nuclear)/ exp(log_Plasmid_nuclear);
+
+// protein synthesis
+
+dxdt_Protein = k_protein*Plasmid_nuclear; 
+
+// degredaded plasmid
+
+dxdt_X_plasmid = k_deg_vesicle*Complex_internal + k_degredation*Plasmid_cytoplasmic; 
+
+[TABLE]
+
+ComplexBound_NPC = exp(log_ComplexBound_NPC) - 0.001; if(ComplexBound_NPC < 0) ComplexBound_NPC = 0;
+ComplexBound_nuclear = exp(log_ComplexBound_nuclear) - 0.001; if(ComplexBound_nuclear < 0) ComplexBound_nuclear = 0;
+Complex_nuclear = exp(log_Complex_nuclear) - 0.001; if(Complex_nuclear < 0) Complex_nuclear = 0;
+Plasmid_nuclear = exp(log_Plasmid_nuclear) - 0.001; if(Plasmid_nuclear < 0) Plasmid_nuclear = 0;
+PlasmidBound_NPC = exp(log_PlasmidBound_NPC) - 0.001; if(PlasmidBound_NPC < 0) PlasmidBound_NPC = 0;
+PlasmidBound_nuclear = exp(log_PlasmidBound_nuclear) - 0.001; if(PlasmidBound_nuclear < 0) PlasmidBound_nuclear = 0;
+
+capture total_plasmid_nuclear =  ComplexBound_NPC + ComplexBound_nuclear + Complex_nuclear + Plasmid_nuclear + PlasmidBound_NPC + PlasmidBound_nuclear; 
+
+capture total_plasmid_cytoplasmic = Complex_internal + Complex_cytoplasmic + ComplexBound_cytoplasmic + Plasmid_cytoplasmic + PlasmidBound_cytoplasmic;
+
+capture total_plasmid = total_plasmid_nuclear + total_plasmid_cytoplasmic;
+
+capture MassBalancePlasmid = Complex_extracellular + total_plasmid + X_plasmid; 
+
+[CAPTURE]
+ComplexBound_NPC, ComplexBound_nuclear, Complex_nuclear, Plasmid_nuclear, PlasmidBound_NPC, PlasmidBound_nuclear
@@ -0,0 +1,91 @@
+// per-thread arena for per-simulation memory in sweeps
+// memory is handed out from large blocks by moving an offset; reset() makes all of it free again in O(1) and keeps
+// the blocks, so once the arena has grown to what one simulation needs, the following simulations allocate nothing
+// system_allocs() counts the blocks taken from the system (the allocation count of a sweep)
+// used by smallode.h
+
+#ifndef MRGARENA_H
+#define MRGARENA_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace mrgarena {
+
+class arena {
+public:
+  explicit arena(size_t block_size = size_t(1) << 16) : block_size_(block_size) {}
+  ~arena(){
+    for(size_t i = 0; i < nblock_; ++i) std::free(blocks_[i].data);
+  }
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  // n values of type T (uninitialized); alignment up to that of malloc
+  template <class T> T* alloc(size_t n){
+    return static_cast<T*>(alloc_bytes(n * sizeof(T), alignof(T)));
+  }
+
+  void* alloc_bytes(size_t bytes, size_t align){
+    for(; cur_ < nblock_; ++cur_, used_ = 0){
+      size_t p = (used_ + align - 1) & ~(align - 1);
+      if(p + bytes <= blocks_[cur_].size){
+        used_ = p + bytes;
+        return blocks_[cur_].data + p;
+      }
+    }
+    grow(bytes);
+    used_ = bytes;
+    return blocks_[cur_].data;
+  }
+
+  // everything handed out since the last reset is free again
+  void reset(){
+    cur_ = 0;
+    used_ = 0;
+  }
+
+  size_t system_allocs() const { return system_allocs_; }
+  size_t capacity() const {
+    size_t c = 0;
+    for(size_t i = 0; i < nblock_; ++i) c += blocks_[i].size;
+    return c;
+  }
+
+private:
+  struct block {
+    char* data;
+    size_t size;
+  };
+  static const size_t max_blocks = 64;
+
+  void grow(size_t bytes){
+    if(nblock_ == max_blocks) throw std::bad_alloc();
+    size_t size = bytes > block_size_ ? bytes : block_size_;
+    char* data = static_cast<char*>(std::malloc(size));
+    if(data == nullptr) throw std::bad_alloc();
+    blocks_[nblock_] = block{data, size};
+    cur_ = nblock_++;
+    ++system_allocs_;
+    block_size_ *= 2; // fewer, larger blocks when a simulation needs more than expected
+  }
+
+  // fixed table, so that growing the arena is the only allocation it makes
+  block blocks_[max_blocks];
+  size_t nblock_ = 0;
+  size_t cur_ = 0;
+  size_t used_ = 0;
+  size_t block_size_;
+  size_t system_allocs_ = 0;
+};
+
+// arena of the calling thread
+inline arena& thread_arena(){
+  thread_local arena a;
+  return a;
+}
+
+} // namespace mrgarena
+
+#endif
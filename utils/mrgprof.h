@@ -0,0 +1,208 @@
+// per-block profiling of mrgsolve models
+// include in the model with [INCLUDE] ../utils/mrgprof.h, name the model in [GLOBAL] with MRG_PROF_MODEL("name"),
+// and put MRG_PROF_MAIN; MRG_PROF_ODE; MRG_PROF_TABLE; at the top of the matching blocks
+// the profiler is compiled in only with -DMRG_PROFILE (see utils/profile.R); otherwise all macros are empty
+//
+// hot path: one cycle counter read at the start and one at the end of each block, added to thread-local totals;
+// every MRG_PROFILE_SAMPLE-th call of a block (default 100) is also kept as a trace event
+// output: Chrome trace format (chrome://tracing, https://ui.perfetto.dev), written by mrgprof_write() or at unload
+// to MRG_PROFILE_OUT/<model>-<pid>.json when the environment variable is set
+
+#ifndef MRGPROF_H
+#define MRGPROF_H
+
+#ifdef MRG_PROFILE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace mrgprof {
+
+enum block_id { block_main = 0, block_ode, block_table, block_preamble, NBLOCK };
+static const char* block_name[NBLOCK] = {"MAIN", "ODE", "TABLE", "PREAMBLE"};
+
+inline uint64_t now_ns(){
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// time stamp counter where available; nanoseconds otherwise
+inline uint64_t cycles(){
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return now_ns();
+#endif
+}
+
+struct block_stats {
+  uint64_t calls = 0;
+  uint64_t cycles = 0;
+  uint64_t cycles_max = 0;
+};
+
+struct trace_event {
+  uint64_t start;
+  uint64_t cycles;
+  int block;
+};
+
+struct thread_data {
+  int tid;
+  block_stats stats[NBLOCK];
+  std::vector<trace_event> events;
+};
+
+struct registry {
+  std::mutex lock;
+  std::vector<thread_data*> threads;
+  std::string model = "model";
+  uint64_t sample = 100;
+  uint64_t max_events = 1000000;
+  uint64_t ns0, cycles0;
+
+  registry() : ns0(now_ns()), cycles0(cycles()) {
+    if(const char* s = std::getenv("MRG_PROFILE_SAMPLE")) sample = std::strtoull(s, nullptr, 10);
+    if(const char* s = std::getenv("MRG_PROFILE_MAX_EVENTS")) max_events = std::strtoull(s, nullptr, 10);
+  }
+
+  ~registry();
+
+  // nanoseconds per cycle, calibrated between the start of the profile and now
+  double ns_per_cycle() const {
+    uint64_t dc = cycles() - cycles0;
+    return dc > 0 ? double(now_ns() - ns0)/ double(dc) : 1.0;
+  }
+
+  void reset(){
+    std::lock_guard<std::mutex> guard(lock);
+    for(thread_data* td : threads){
+      for(int b = 0; b < NBLOCK; ++b) td->stats[b] = block_stats();
+      td->events.clear();
+    }
+    ns0 = now_ns();
+    cycles0 = cycles();
+  }
+
+  bool write(const char* path);
+};
+
+inline registry& reg(){
+  static registry r;
+  return r;
+}
+
+// thread data is owned by the registry, so that the totals outlive the threads
+inline thread_data& local(){
+  static thread_local thread_data* td = nullptr;
+  if(td == nullptr){
+    registry& r = reg();
+    std::lock_guard<std::mutex> guard(r.lock);
+    td = new thread_data();
+    td->tid = int(r.threads.size());
+    r.threads.push_back(td);
+  }
+  return *td;
+}
+
+class scope {
+public:
+  explicit scope(block_id b) : block_(b), start_(cycles()) {}
+  ~scope(){
+    uint64_t dc = cycles() - start_;
+    thread_data& td = local();
+    block_stats& s = td.stats[block_];
+    s.calls++;
+    s.cycles += dc;
+    if(dc > s.cycles_max) s.cycles_max = dc;
+    const registry& r = reg();
+    if(r.sample > 0 && (s.calls - 1) % r.sample == 0 && td.events.size() < r.max_events){
+      td.events.push_back(trace_event{start_, dc, block_});
+    }
+  }
+private:
+  block_id block_;
+  uint64_t start_;
+};
+
+inline bool registry::write(const char* path){
+  std::lock_guard<std::mutex> guard(lock);
+  FILE* f = std::fopen(path, "w");
+  if(f == nullptr) return false;
+  double k = ns_per_cycle();
+  int pid = int(getpid());
+
+  std::fprintf(f, "{\"traceEvents\":[\n");
+  std::fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s (%d)\"}}", pid, model.c_str(), pid);
+  for(const thread_data* td : threads){
+    std::fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}", pid, td->tid, td->tid);
+    for(const trace_event& e : td->events){
+      double ts = (double(e.start) - double(cycles0)) * k/ 1000.0;
+      std::fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                   block_name[e.block], model.c_str(), pid, td->tid, ts, double(e.cycles) * k/ 1000.0);
+    }
+  }
+  std::fprintf(f, "\n],\n\"displayTimeUnit\":\"ns\",\n\"otherData\":{\"model\":\"%s\",\"pid\":%d,\"sample\":%llu,\"ns_per_cycle\":%.6g,\"summary\":[",
+               model.c_str(), pid, (unsigned long long)sample, k);
+  bool first = true;
+  for(const thread_data* td : threads){
+    for(int b = 0; b < NBLOCK; ++b){
+      const block_stats& s = td->stats[b];
+      if(s.calls == 0) continue;
+      std::fprintf(f, "%s\n{\"tid\":%d,\"block\":\"%s\",\"calls\":%llu,\"cycles\":%llu,\"ns\":%.0f,\"ns_max\":%.0f}",
+                   first ? "" : ",", td->tid, block_name[b], (unsigned long long)s.calls, (unsigned long long)s.cycles,
+                   double(s.cycles) * k, double(s.cycles_max) * k);
+      first = false;
+    }
+  }
+  std::fprintf(f, "\n]}}\n");
+  std::fclose(f);
+  return true;
+}
+
+inline registry::~registry(){
+  if(const char* dir = std::getenv("MRG_PROFILE_OUT")){
+    std::string path = std::string(dir) + "/" + model + "-" + std::to_string(getpid()) + ".json";
+    write(path.c_str());
+  }
+  for(thread_data* td : threads) delete td;
+}
+
+struct model_name {
+  explicit model_name(const char* name){ reg().model = name; }
+};
+
+} // namespace mrgprof
+
+// called from R with .C(); see utils/profile.R
+// the header is included once per model, so these are defined here
+extern "C" {
+void mrgprof_write(char** path, int* ok){ *ok = mrgprof::reg().write(path[0]); }
+void mrgprof_reset(){ mrgprof::reg().reset(); }
+}
+
+#define MRG_PROF_MODEL(name) static mrgprof::model_name mrgprof_model_name_(name)
+#define MRG_PROF_SCOPE(block) mrgprof::scope mrgprof_scope_(mrgprof::block)
+
+#else
+
+// a declaration that does nothing, so that the ; after MRG_PROF_MODEL(name) in [GLOBAL] is not a stray one
+#define MRG_PROF_MODEL(name) static_assert(true, "")
+#define MRG_PROF_SCOPE(block) do {} while(0)
+
+#endif // MRG_PROFILE
+
+#define MRG_PROF_MAIN MRG_PROF_SCOPE(block_main)
+#define MRG_PROF_ODE MRG_PROF_SCOPE(block_ode)
+#define MRG_PROF_TABLE MRG_PROF_SCOPE(block_table)
+#define MRG_PROF_PREAMBLE MRG_PROF_SCOPE(block_preamble)
+
+#endif // MRGPROF_H
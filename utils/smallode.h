@@ -0,0 +1,450 @@
+// solvers for small models with the number of states fixed at compile time, and a sweep driver that writes each
+// simulation straight into its rows of a preallocated output matrix
+//   RK:         explicit Dormand-Prince 5(4), first-same-as-last, step size control and stiffness detection as in
+//               Hairer et al., Solving Ordinary Differential Equations I
+//   ROSENBROCK: linearly implicit 4(3) method (Shampine's parameters, as in Hairer and Wanner's ROS4) for stiff
+//               models; one finite-difference Jacobian and one LU factorization (partial pivoting) per step
+//   AUTO:       RK until the stiffness test fires, then ROSENBROCK for the rest of the simulation
+// with at most SMALLODE_MAX_FIXED states, the state, the stages, the Jacobian and its LU factors are std::array on the
+// stack and every loop over the state (including the LU factorization and solves) has a compile-time trip count, so
+// the compiler unrolls it for the model; larger models take the same workspace from the thread's arena (arena.h),
+// which is reset in O(1) between simulations
+// the state, stages and LU factors are of type Real: double, or float for screening sweeps (twice the states per
+// vector register and cache line); time and step size are always double, and with float each simulation gets a
+// status flag (maxsteps, a stalled step size control, or a state outside the range that float represents safely) so
+// that the caller can run the flagged simulations again in double
+// a model is a class with
+//   static const int nstate, npar
+//   void set(const double* p)                          parameters of one simulation
+//   void init(double* x0) const                        initial state after [MAIN] (x0 holds the <cmt>_0 values)
+//   template <class Real> void rhs(double t, const Real* x, Real* dx) const
+// used by smallsweep.R, which generates the model class from a model file
+
+#ifndef SMALLODE_H
+#define SMALLODE_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "arena.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef SMALLODE_MAX_FIXED
+#define SMALLODE_MAX_FIXED 8
+#endif
+
+namespace smallode {
+
+enum method { RK = 0, ROSENBROCK = 1, AUTO = 2 };
+
+// outcome of one simulation
+enum status { OK = 0, MAXSTEPS = 1, STALLED = 2, RANGE = 3 };
+
+// consecutive rejected steps after which the step size control counts as stalled (in float: the error estimate is
+// at the level of rounding)
+const int max_reject = 12;
+
+// largest state magnitude that a float simulation may reach without being flagged (products of two states and a rate
+// constant stay far from FLT_MAX)
+const double float_guard = 1e15;
+
+struct options {
+  double rtol = 1e-8;
+  double atol = 1e-8;
+  double hmax = 0; // 0: no limit
+  long maxsteps = 20000;
+  int method = AUTO;
+};
+
+// doubles of workspace per state: x, y, ytmp and seven stage vectors (shared by both methods)
+const int work_per_state = 10;
+
+// weighted RMS norm of v with the scale of x (and y)
+template <int N, class Real>
+inline double wrms(const Real* v, const Real* x, const Real* y, int n, const options& o){
+  const int nn = N > 0 ? N : n;
+  double s = 0;
+  for(int i = 0; i < nn; ++i){
+    double sc = o.atol + o.rtol * std::max(std::fabs(double(x[i])), std::fabs(double(y[i])));
+    double r = v[i]/ sc;
+    s += r * r;
+  }
+  return std::sqrt(s/ nn);
+}
+
+//---- dense LU ----//
+
+// LU factorization with partial pivoting of the row-major nn x nn matrix a, in place; false if singular
+template <int N, class Real>
+inline bool lu_factor(Real* a, int* piv, int n){
+  const int nn = N > 0 ? N : n;
+  for(int k = 0; k < nn; ++k){
+    int p = k;
+    Real big = std::fabs(a[k * nn + k]);
+    for(int i = k + 1; i < nn; ++i){
+      if(std::fabs(a[i * nn + k]) > big){
+        big = std::fabs(a[i * nn + k]);
+        p = i;
+      }
+    }
+    piv[k] = p;
+    if(big == 0) return false;
+    if(p != k) for(int j = 0; j < nn; ++j) std::swap(a[k * nn + j], a[p * nn + j]);
+    const Real inv = 1/ a[k * nn + k];
+    for(int i = k + 1; i < nn; ++i){
+      const Real l = a[i * nn + k] * inv;
+      a[i * nn + k] = l;
+      for(int j = k + 1; j < nn; ++j) a[i * nn + j] -= l * a[k * nn + j];
+    }
+  }
+  return true;
+}
+
+// solve (LU) x = b in place
+template <int N, class Real>
+inline void lu_solve(const Real* a, const int* piv, Real* b, int n){
+  const int nn = N > 0 ? N : n;
+  for(int k = 0; k < nn; ++k){
+    if(piv[k] != k) std::swap(b[k], b[piv[k]]);
+    for(int i = k + 1; i < nn; ++i) b[i] -= a[i * nn + k] * b[k];
+  }
+  for(int i = nn - 1; i >= 0; --i){
+    for(int j = i + 1; j < nn; ++j) b[i] -= a[i * nn + j] * b[j];
+    b[i] /= a[i * nn + i];
+  }
+}
+
+// Jacobian (row major) by forward differences at (t, x) with f = f(t, x); xt, ft: scratch vectors
+template <int N, class Real, class Model>
+inline void jacobian(const Model& m, double t, const Real* x, const Real* f, Real* jac, Real* xt, Real* ft, int n){
+  const int nn = N > 0 ? N : n;
+  for(int i = 0; i < nn; ++i) xt[i] = x[i];
+  for(int j = 0; j < nn; ++j){
+    const double d = std::sqrt(double(std::numeric_limits<Real>::epsilon())) * std::max(1e-5, std::fabs(double(x[j])));
+    xt[j] = x[j] + Real(d);
+    const Real dj = xt[j] - x[j]; // the increment after rounding
+    m.rhs(t, xt, ft);
+    for(int i = 0; i < nn; ++i) jac[i * nn + j] = (ft[i] - f[i])/ dj;
+    xt[j] = x[j];
+  }
+}
+
+//---- integrator ----//
+
+// workspace of one simulation; jac and lu are nn x nn, piv nn
+template <class Real>
+struct work {
+  Real* v;
+  Real* jac;
+  Real* lu;
+  int* piv;
+};
+
+// integrate from times[0] through times[nt - 1], starting from w.v[0..n-1]; the state at each output time goes to
+// out[j * ldo + i] (time i, state j); the rows that are not reached (maxsteps) are NaN
+// N: number of states if known at compile time, 0 otherwise (then n)
+// returns MAXSTEPS if maxsteps was reached, STALLED if max_reject steps in a row were rejected at some point, else OK
+template <int N, class Real, class Model>
+int integrate(const Model& m, int n, work<Real> w, const double* times, int nt, double* out, size_t ldo,
+              const options& o){
+  typedef Real R;
+  const int nn = N > 0 ? N : n;
+  R* x = w.v;
+  R* y = w.v + nn;
+  R* yt = w.v + 2 * nn;
+  R* k1 = w.v + 3 * nn;
+  R* k2 = w.v + 4 * nn;
+  R* k3 = w.v + 5 * nn;
+  R* k4 = w.v + 6 * nn;
+  R* k5 = w.v + 7 * nn;
+  R* k6 = w.v + 8 * nn;
+  R* k7 = w.v + 9 * nn;
+
+  double t = times[0];
+  int io = 0;
+  m.rhs(t, x, k1);
+  bool stiff = o.method == ROSENBROCK;
+  int nstiff = 0;
+  int nnonstiff = 0;
+
+  // starting step (Hairer et al., II.4)
+  const double span = times[nt - 1] - t;
+  double h = span;
+  if(span > 0){
+    double d0 = wrms<N>(x, x, x, nn, o);
+    double d1 = wrms<N>(k1, x, x, nn, o);
+    double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 * span : 0.01 * d0/ d1;
+    h0 = std::min(h0, span);
+    for(int i = 0; i < nn; ++i) yt[i] = x[i] + R(h0) * k1[i];
+    m.rhs(t + h0, yt, k2);
+    for(int i = 0; i < nn; ++i) k3[i] = (k2[i] - k1[i])/ R(h0);
+    double d2 = wrms<N>(k3, x, x, nn, o);
+    double dm = std::max(d1, d2);
+    double h1 = dm <= 1e-15 ? std::max(1e-6 * span, h0 * 1e-3) : std::pow(0.01/ dm, 0.2);
+    h = std::min(100 * h0, h1);
+  }
+  if(o.hmax > 0) h = std::min(h, o.hmax);
+
+  long steps = 0;
+  int rejected = 0; // in a row
+  bool stalled = false;
+  bool fresh_jac = false; // Jacobian is current for (t, x)
+  while(io < nt){
+    const double tout = times[io];
+    if(t >= tout){
+      for(int j = 0; j < nn; ++j) out[j * ldo + io] = x[j];
+      ++io;
+      continue;
+    }
+    if(steps >= o.maxsteps){
+      for(; io < nt; ++io) for(int j = 0; j < nn; ++j) out[j * ldo + io] = std::numeric_limits<double>::quiet_NaN();
+      return MAXSTEPS;
+    }
+
+    const bool hit = tout - t <= h;
+    const double hh = hit ? tout - t : h;
+    const R hr = R(hh);
+    double err, fac;
+
+    // coefficients are rounded to Real at compile time, so that the stage arithmetic stays in Real
+    if(!stiff){
+      for(int i = 0; i < nn; ++i) yt[i] = x[i] + hr * (R(1.0/5) * k1[i]);
+      m.rhs(t + hh/ 5, yt, k2);
+      for(int i = 0; i < nn; ++i) yt[i] = x[i] + hr * (R(3.0/40) * k1[i] + R(9.0/40) * k2[i]);
+      m.rhs(t + 3 * hh/ 10, yt, k3);
+      for(int i = 0; i < nn; ++i) yt[i] = x[i] + hr * (R(44.0/45) * k1[i] - R(56.0/15) * k2[i] + R(32.0/9) * k3[i]);
+      m.rhs(t + 4 * hh/ 5, yt, k4);
+      for(int i = 0; i < nn; ++i){
+        yt[i] = x[i] + hr * (R(19372.0/6561) * k1[i] - R(25360.0/2187) * k2[i] + R(64448.0/6561) * k3[i]
+                             - R(212.0/729) * k4[i]);
+      }
+      m.rhs(t + 8 * hh/ 9, yt, k5);
+      for(int i = 0; i < nn; ++i){
+        yt[i] = x[i] + hr * (R(9017.0/3168) * k1[i] - R(355.0/33) * k2[i] + R(46732.0/5247) * k3[i]
+                             + R(49.0/176) * k4[i] - R(5103.0/18656) * k5[i]);
+      }
+      m.rhs(t + hh, yt, k6);
+      for(int i = 0; i < nn; ++i){
+        y[i] = x[i] + hr * (R(35.0/384) * k1[i] + R(500.0/1113) * k3[i] + R(125.0/192) * k4[i]
+                            - R(2187.0/6784) * k5[i] + R(11.0/84) * k6[i]);
+      }
+      m.rhs(t + hh, y, k7);
+
+      // stiffness test: estimate of h * |lambda| from the last two stages (Hairer et al., IV.2)
+      double hlamb = 0;
+      if(o.method == AUTO){
+        double num = 0, den = 0;
+        for(int i = 0; i < nn; ++i){
+          num += double(k7[i] - k6[i]) * double(k7[i] - k6[i]);
+          den += double(y[i] - yt[i]) * double(y[i] - yt[i]);
+        }
+        if(den > 0) hlamb = hh * std::sqrt(num/ den);
+      }
+
+      // error estimate: difference of the 5th and 4th order solutions
+      for(int i = 0; i < nn; ++i){
+        yt[i] = hr * (R(71.0/57600) * k1[i] - R(71.0/16695) * k3[i] + R(71.0/1920) * k4[i]
+                      - R(17253.0/339200) * k5[i] + R(22.0/525) * k6[i] - R(1.0/40) * k7[i]);
+      }
+      err = wrms<N>(yt, x, y, nn, o);
+      fac = err == 0 ? 10 : std::min(10.0, std::max(0.2, 0.9 * std::pow(err, -0.2)));
+
+      if(err <= 1 && o.method == AUTO){
+        if(hlamb > 3.25){
+          nnonstiff = 0;
+          if(++nstiff == 15) stiff = true;
+        } else if(++nnonstiff == 6){
+          nstiff = 0;
+        }
+      }
+    } else {
+      // Rosenbrock 4(3); stages in k3..k6, f(t, x) in k1, df/dt in k2
+      const double gam = 0.5;
+      if(!fresh_jac){
+        jacobian<N>(m, t, x, k1, w.jac, yt, k7, nn);
+        const double dt = std::sqrt(std::numeric_limits<R>::epsilon()) * std::max(1.0, std::fabs(t));
+        m.rhs(t + dt, x, k7);
+        for(int i = 0; i < nn; ++i) k2[i] = (k7[i] - k1[i])/ R(dt);
+        fresh_jac = true;
+      }
+      for(int i = 0; i < nn * nn; ++i) w.lu[i] = -w.jac[i];
+      for(int i = 0; i < nn; ++i) w.lu[i * nn + i] += R(1/ (gam * hh));
+      if(!lu_factor<N>(w.lu, w.piv, nn)){
+        h = hh/ 2;
+        ++steps;
+        continue;
+      }
+
+      for(int i = 0; i < nn; ++i) k3[i] = k1[i] + hr * R(0.5) * k2[i];
+      lu_solve<N>(w.lu, w.piv, k3, nn);
+      for(int i = 0; i < nn; ++i) yt[i] = x[i] + 2 * k3[i];
+      m.rhs(t + hh, yt, k7);
+      for(int i = 0; i < nn; ++i) k4[i] = k7[i] - hr * R(1.5) * k2[i] - 8 * k3[i]/ hr;
+      lu_solve<N>(w.lu, w.piv, k4, nn);
+      for(int i = 0; i < nn; ++i) yt[i] = x[i] + R(48.0/25) * k3[i] + R(6.0/25) * k4[i];
+      m.rhs(t + 3 * hh/ 5, yt, k7);
+      for(int i = 0; i < nn; ++i){
+        k5[i] = k7[i] + hr * R(121.0/50) * k2[i] + (R(372.0/25) * k3[i] + R(12.0/5) * k4[i])/ hr;
+      }
+      lu_solve<N>(w.lu, w.piv, k5, nn);
+      for(int i = 0; i < nn; ++i){
+        k6[i] = k7[i] + hr * R(29.0/250) * k2[i] + (R(-112.0/125) * k3[i] - R(54.0/125) * k4[i] - R(2.0/5) * k5[i])/ hr;
+      }
+      lu_solve<N>(w.lu, w.piv, k6, nn);
+      for(int i = 0; i < nn; ++i){
+        y[i] = x[i] + R(19.0/9) * k3[i] + R(0.5) * k4[i] + R(25.0/108) * k5[i] + R(125.0/108) * k6[i];
+        yt[i] = R(17.0/54) * k3[i] + R(7.0/36) * k4[i] + R(125.0/108) * k6[i];
+      }
+      // error estimate: difference of the 4th and 3rd order solutions, filtered with (I - gam h J)^-1 (Shampine)
+      // the embedded solution is not L-stable, so in the raw difference the stiff components (e.g. a state that sits
+      // at quasi-steady state within atol) are amplified by a factor that does not go to 0 with h, and the step size
+      // control stalls at tight atol; the filter leaves the non-stiff components as they are
+      lu_solve<N>(w.lu, w.piv, yt, nn);
+      for(int i = 0; i < nn; ++i) yt[i] *= R(1/ (gam * hh));
+      err = wrms<N>(yt, x, y, nn, o);
+      fac = err == 0 ? 4 : std::min(4.0, std::max(0.2, 0.9 * std::pow(err, -0.25)));
+    }
+    ++steps;
+
+    if(err <= 1){
+      rejected = 0;
+      t = hit ? tout : t + hh;
+      std::swap(x, y);
+      if(stiff){
+        m.rhs(t, x, k1);
+        fresh_jac = false;
+      } else {
+        std::swap(k1, k7);
+      }
+      // a step shortened to hit an output time does not shrink the next one
+      h = (hit && fac >= 1) ? std::max(h, hh * fac) : hh * fac;
+    } else {
+      h = hh * fac;
+      if(++rejected == max_reject) stalled = true;
+    }
+    if(o.hmax > 0) h = std::min(h, o.hmax);
+  }
+  return stalled ? STALLED : OK;
+}
+
+// one simulation: workspace on the stack (std::array sized by the model) when the model is small enough, otherwise
+// (or with fixed = false) from the arena; returns a status
+template <class Model, class Real, bool Small = (Model::nstate <= SMALLODE_MAX_FIXED)>
+struct run_one {
+  static int run(const Model& m, const double* x0, const double* times, int nt, double* out, size_t ldo,
+                 const options& o, bool fixed, mrgarena::arena& a){
+    if(!fixed) return run_one<Model, Real, false>::run(m, x0, times, nt, out, ldo, o, fixed, a);
+    const int n = Model::nstate;
+    std::array<Real, work_per_state * n> v;
+    std::array<Real, n * n> jac, lu;
+    std::array<int, n> piv;
+    std::copy(x0, x0 + n, v.begin());
+    return integrate<n>(m, n, work<Real>{v.data(), jac.data(), lu.data(), piv.data()}, times, nt, out, ldo, o);
+  }
+};
+
+template <class Model, class Real>
+struct run_one<Model, Real, false> {
+  static int run(const Model& m, const double* x0, const double* times, int nt, double* out, size_t ldo,
+                 const options& o, bool, mrgarena::arena& a){
+    const int n = Model::nstate;
+    a.reset();
+    work<Real> w;
+    w.v = a.alloc<Real>(size_t(work_per_state) * n);
+    w.jac = a.alloc<Real>(size_t(n) * n);
+    w.lu = a.alloc<Real>(size_t(n) * n);
+    w.piv = a.alloc<int>(n);
+    std::copy(x0, x0 + n, w.v);
+    return integrate<0>(m, n, w, times, nt, out, ldo, o);
+  }
+};
+
+// RANGE if a float simulation left [-float_guard, float_guard] or produced a non-finite value
+template <class Real>
+inline int check_range(int st, const double* out, size_t ldo, int nt, int n){
+  if(st == MAXSTEPS || sizeof(Real) >= sizeof(double)) return st;
+  for(int j = 0; j < n; ++j){
+    for(int r = 0; r < nt; ++r) if(!(std::fabs(out[j * ldo + r]) <= float_guard)) return RANGE;
+  }
+  return st;
+}
+
+struct sweep_result {
+  long failed = 0;
+  long flagged = 0;         // simulations with a status other than OK
+  size_t system_allocs = 0; // blocks taken by the arenas during the sweep
+  size_t steady_allocs = 0; // of which after the first simulation of each thread (0 when nothing is allocated per run)
+};
+
+// nsim simulations; par: nsim x npar, x0: nsim x nstate (<cmt>_0 values), both column major
+// out: (nsim * nt) x (2 + nstate), column major, columns ID, time, states; rows of simulation i are i * nt + (0..nt-1)
+// flags: nsim status values (may be null)
+template <class Model, class Real = double>
+sweep_result sweep(const double* par, const double* id, const double* x0, int nsim, const double* times, int nt,
+                   double* out, const options& o, bool fixed, int nthreads, int* flags = nullptr){
+  const int n = Model::nstate;
+  const size_t ldo = size_t(nsim) * nt;
+#ifdef _OPENMP
+  if(nthreads < 1) nthreads = omp_get_max_threads();
+#else
+  nthreads = 1;
+#endif
+  // arena counts per thread, at the start, after the first simulation and at the end
+  const size_t unset = std::numeric_limits<size_t>::max();
+  std::vector<size_t> start(nthreads, unset), first(nthreads, unset), last(nthreads, unset);
+  long failed = 0, flagged = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) num_threads(nthreads) reduction(+:failed, flagged)
+#endif
+  for(int i = 0; i < nsim; ++i){
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+#else
+    const int tid = 0;
+#endif
+    mrgarena::arena& a = mrgarena::thread_arena();
+    if(start[tid] == unset) start[tid] = a.system_allocs();
+
+    std::array<double, (Model::npar > 0 ? Model::npar : 1)> p;
+    std::array<double, n> xi;
+    for(int k = 0; k < Model::npar; ++k) p[k] = par[size_t(k) * nsim + i];
+    for(int j = 0; j < n; ++j) xi[j] = x0[size_t(j) * nsim + i];
+    Model m;
+    m.set(p.data());
+    m.init(xi.data());
+
+    const size_t row = size_t(i) * nt;
+    for(int r = 0; r < nt; ++r){
+      out[row + r] = id[i];
+      out[ldo + row + r] = times[r];
+    }
+    int st = run_one<Model, Real>::run(m, xi.data(), times, nt, out + 2 * ldo + row, ldo, o, fixed, a);
+    st = check_range<Real>(st, out + 2 * ldo + row, ldo, nt, n);
+    if(st == MAXSTEPS) ++failed;
+    if(st != OK) ++flagged;
+    if(flags != nullptr) flags[i] = st;
+
+    if(first[tid] == unset) first[tid] = a.system_allocs();
+    last[tid] = a.system_allocs();
+  }
+
+  sweep_result res;
+  res.failed = failed;
+  res.flagged = flagged;
+  for(int k = 0; k < nthreads; ++k){
+    if(start[k] == unset) continue;
+    res.system_allocs += last[k] - start[k];
+    res.steady_allocs += last[k] - first[k];
+  }
+  return res;
+}
+
+} // namespace smallode
+
+#endif
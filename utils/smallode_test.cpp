@@ -0,0 +1,154 @@
+// checks of the small-model solvers (smallode.h) that do not need R
+//   robertson: the stiff Robertson problem at tight atol finishes with status OK (no stalled step size control) with
+//              ROSENBROCK and AUTO, with the workspace on the stack and from the arena
+//   allocations: after one warm-up simulation, run_one over many parameter sets allocates nothing (malloc is counted
+//              with glibc, operator new otherwise), with the workspace on the stack and from the arena, in double and
+//              float
+// usage (from this folder): g++ -O2 -std=c++11 -o smallode_test smallode_test.cpp && ./smallode_test
+// exit status 0 if all checks pass
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "smallode.h"
+
+//---- allocation counter ----//
+
+static bool counting = false;
+static long allocs = 0;
+
+static void* volatile sink = nullptr;
+
+#ifdef __GLIBC__
+// every allocation (operator new of libstdc++ and libc++ included) goes through malloc
+extern "C" void* __libc_malloc(size_t n);
+extern "C" void* malloc(size_t n){
+  if(counting) ++allocs;
+  return __libc_malloc(n);
+}
+#else
+void* operator new(size_t n){
+  if(counting) ++allocs;
+  void* p = std::malloc(n > 0 ? n : 1);
+  if(p == nullptr) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t n){ return operator new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+#endif
+
+// Robertson's chemical kinetics (Hairer and Wanner, II.1); rate constants as parameters
+struct robertson {
+  static const int nstate = 3, npar = 3;
+  double k[3];
+  void set(const double* p){ for(int i = 0; i < npar; ++i) k[i] = p[i]; }
+  void init(double*) const {}
+  template <class Real> void rhs(double, const Real* x, Real* dx) const {
+    const Real k1 = Real(k[0]), k2 = Real(k[1]), k3 = Real(k[2]);
+    dx[0] = -k1 * x[0] + k2 * x[1] * x[2];
+    dx[1] = k1 * x[0] - k2 * x[1] * x[2] - k3 * x[1] * x[1];
+    dx[2] = k3 * x[1] * x[1];
+  }
+};
+
+// linear chain of nstate first-order transfers, for a model above SMALLODE_MAX_FIXED (workspace from the arena)
+struct chain {
+  static const int nstate = 12, npar = 1;
+  double k;
+  void set(const double* p){ k = p[0]; }
+  void init(double*) const {}
+  template <class Real> void rhs(double, const Real* x, Real* dx) const {
+    dx[0] = -Real(k) * x[0];
+    for(int i = 1; i < nstate; ++i) dx[i] = Real(k) * (x[i - 1] - x[i]);
+  }
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what){
+  std::printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  if(!ok) ++failures;
+}
+
+static void test_robertson(){
+  const double par[3] = {0.04, 1e4, 3e7}, id[1] = {1}, x0[3] = {1, 0, 0};
+  const int nt = 13;
+  double times[nt];
+  times[0] = 0;
+  for(int r = 1; r < nt; ++r) times[r] = std::pow(10.0, r - 2); // 0.1 through 1e10
+  const int methods[2] = {smallode::ROSENBROCK, smallode::AUTO};
+  const char* names[2] = {"ROSENBROCK", "AUTO"};
+
+  for(int m = 0; m < 2; ++m){
+    for(int fixed = 0; fixed < 2; ++fixed){
+      double out[nt * 5];
+      int flag = -1;
+      smallode::options o;
+      o.rtol = 1e-6;
+      o.atol = 1e-10;
+      o.method = methods[m];
+      smallode::sweep<robertson>(par, id, x0, 1, times, nt, out, o, fixed != 0, 1, &flag);
+      // mass is conserved, and the last state is close to the known limit x1 ~ 2.08e-7 at t = 1e10
+      const double mass = out[2 * nt + nt - 1] + out[3 * nt + nt - 1] + out[4 * nt + nt - 1];
+      char what[128];
+      std::snprintf(what, sizeof(what), "robertson, rtol 1e-6, atol 1e-10, %s, workspace %s", names[m],
+                    fixed ? "on the stack" : "from the arena");
+      check(flag == smallode::OK && std::fabs(mass - 1) < 1e-6 && std::fabs(out[2 * nt + nt - 1]/ 2.0833e-7 - 1) < 1e-2,
+            what);
+    }
+  }
+}
+
+// allocations of run_one over nsim parameter sets after one warm-up simulation
+template <class Model, class Real>
+static long run_allocs(const double* p0, bool fixed, int method){
+  const int n = Model::nstate, nt = 25, nsim = 500;
+  double times[nt], x0[n], out[n * nt];
+  for(int r = 0; r < nt; ++r) times[r] = r;
+  smallode::options o;
+  o.rtol = 1e-6;
+  o.atol = 1e-10;
+  o.method = method;
+  mrgarena::arena& a = mrgarena::thread_arena();
+  double p[Model::npar];
+  for(int sim = 0; sim <= nsim; ++sim){
+    if(sim == 1){ // after the warm-up
+      allocs = 0;
+      counting = true;
+    }
+    for(int k = 0; k < Model::npar; ++k) p[k] = p0[k] * std::exp(std::sin(sim + k)); // parameters within e^-1..e
+    for(int j = 0; j < n; ++j) x0[j] = j == 0 ? 1 : 0;
+    Model m;
+    m.set(p);
+    m.init(x0);
+    smallode::run_one<Model, Real>::run(m, x0, times, nt, out, nt, o, fixed, a);
+  }
+  counting = false;
+  return allocs;
+}
+
+static void test_allocations(){
+  allocs = 0;
+  counting = true;
+  sink = new double[4];
+  counting = false;
+  delete[] static_cast<double*>(sink);
+  check(allocs > 0, "allocation counter");
+
+  const double rob[3] = {0.04, 1e4, 3e7}, k[1] = {0.5};
+  check(run_allocs<robertson, double>(rob, true, smallode::AUTO) == 0, "allocations, robertson, double, on the stack");
+  check(run_allocs<robertson, double>(rob, false, smallode::AUTO) == 0,
+        "allocations, robertson, double, from the arena");
+  check(run_allocs<robertson, float>(rob, true, smallode::AUTO) == 0, "allocations, robertson, float, on the stack");
+  check(run_allocs<chain, double>(k, true, smallode::RK) == 0, "allocations, 12-state chain, RK, from the arena");
+  check(run_allocs<chain, double>(k, true, smallode::ROSENBROCK) == 0,
+        "allocations, 12-state chain, ROSENBROCK, from the arena");
+}
+
+int main(){
+  test_robertson();
+  test_allocations();
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+// R interface to the trajectory codec (trajcodec.h)
+// usage: Rcpp::sourceCpp("../utils/trajcodec.cpp"), or source("../utils/trajcodec.R")
+
+#include <Rcpp.h>
+#include "trajcodec.h"
+
+using namespace Rcpp;
+
+// encode the rows of x (sorted by id) as one block per id
+// output: list(data = encoded blocks back to back, id, offset, length) with 0-based byte offsets
+// [[Rcpp::export]]
+List traj_encode_blocks(NumericMatrix x, NumericVector id){
+  const size_t n = x.nrow();
+  const uint32_t ncol = x.ncol();
+  if(size_t(id.size()) != n) stop("id must have one value per row");
+
+  std::vector<uint8_t> out, col_a, col_b, scratch;
+  std::vector<double> block, ids, offset, length;
+  out.reserve(n * ncol * 4);
+
+  size_t start = 0;
+  while(start < n){
+    size_t end = start + 1;
+    while(end < n && id[end] == id[start]) ++end;
+    const uint32_t nrow = uint32_t(end - start);
+
+    // copy the rows of this id into a column-major block
+    block.resize(size_t(nrow) * ncol);
+    for(uint32_t j = 0; j < ncol; ++j){
+      const double* col = &x(0, j);
+      std::copy(col + start, col + end, block.begin() + size_t(j) * nrow);
+    }
+
+    size_t before = out.size();
+    trajcodec::encode_block(block.data(), nrow, ncol, out, col_a, col_b, scratch);
+    ids.push_back(id[start]);
+    offset.push_back(double(before));
+    length.push_back(double(out.size() - before));
+    start = end;
+  }
+
+  RawVector data(out.size());
+  std::copy(out.begin(), out.end(), data.begin());
+  return List::create(_["data"] = data, _["id"] = wrap(ids), _["offset"] = wrap(offset), _["length"] = wrap(length));
+}
+
+// decode blocks from data (offset/ length as returned by traj_encode_blocks) into one matrix, rows in block order
+// [[Rcpp::export]]
+NumericMatrix traj_decode_blocks(RawVector data, NumericVector offset, NumericVector length){
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(RAW(data));
+  const size_t nbytes = data.size();
+  const int nb = offset.size();
+
+  size_t nrow_total = 0;
+  uint32_t ncol = 0;
+  for(int b = 0; b < nb; ++b){
+    if(offset[b] + length[b] > double(nbytes)) stop("block %d is out of range", b + 1);
+    uint32_t nrow, nc;
+    trajcodec::block_dim(p + size_t(offset[b]), size_t(length[b]), nrow, nc);
+    if(b > 0 && nc != ncol) stop("blocks have different numbers of columns");
+    ncol = nc;
+    nrow_total += nrow;
+  }
+
+  NumericMatrix x(nrow_total, ncol);
+  std::vector<double> block;
+  std::vector<uint8_t> scratch;
+  size_t row = 0;
+  for(int b = 0; b < nb; ++b){
+    const uint8_t* q = p + size_t(offset[b]);
+    uint32_t nrow, nc;
+    trajcodec::block_dim(q, size_t(length[b]), nrow, nc);
+    block.resize(size_t(nrow) * ncol);
+    try {
+      trajcodec::decode_block(q, size_t(length[b]), block.data(), scratch);
+    } catch(std::exception& e){
+      stop(e.what());
+    }
+    for(uint32_t j = 0; j < ncol; ++j){
+      std::copy(block.begin() + size_t(j) * nrow, block.begin() + size_t(j + 1) * nrow, &x(row, j));
+    }
+    row += nrow;
+  }
+  return x;
+}
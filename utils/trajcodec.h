@@ -0,0 +1,271 @@
+// lossless codec for simulated trajectories
+// a block is one simulation (nrow output times x ncol columns of doubles), stored column by column
+// each column is encoded with the smaller of
+//   GORILLA: XOR with the previous value, leading/ trailing zero bits packed as in Gorilla (Pelkonen et al., 2015)
+//   SHUFFLE: delta of the bit patterns (zigzag), bytes shuffled into 8 planes, zero runs coded as run lengths
+// smooth columns give XOR/ delta residuals with many zero high bytes, which both encodings remove
+// used by trajcodec.cpp (R interface)
+
+#ifndef TRAJCODEC_H
+#define TRAJCODEC_H
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace trajcodec {
+
+enum method : uint8_t { GORILLA = 1, SHUFFLE = 2 };
+
+inline uint64_t bits_of(double x){
+  uint64_t u;
+  std::memcpy(&u, &x, sizeof(u));
+  return u;
+}
+
+inline double double_of(uint64_t u){
+  double x;
+  std::memcpy(&x, &u, sizeof(x));
+  return x;
+}
+
+inline int clz64(uint64_t x){ return x == 0 ? 64 : __builtin_clzll(x); }
+inline int ctz64(uint64_t x){ return x == 0 ? 64 : __builtin_ctzll(x); }
+
+//---- bit stream ----//
+
+class bit_writer {
+public:
+  explicit bit_writer(std::vector<uint8_t>& out) : out_(out), acc_(0), nacc_(0) {}
+  // write the lowest n bits of v (n <= 64), most significant first
+  void put(uint64_t v, int n){
+    while(n > 0){
+      int take = n < 32 ? n : 32;
+      n -= take;
+      uint64_t chunk = (v >> n) & ((1ULL << take) - 1);
+      acc_ = (acc_ << take) | chunk;
+      nacc_ += take;
+      while(nacc_ >= 8){
+        nacc_ -= 8;
+        out_.push_back(uint8_t(acc_ >> nacc_));
+      }
+    }
+  }
+  void flush(){
+    if(nacc_ > 0) out_.push_back(uint8_t(acc_ << (8 - nacc_)));
+    acc_ = 0;
+    nacc_ = 0;
+  }
+private:
+  std::vector<uint8_t>& out_;
+  uint64_t acc_;
+  int nacc_;
+};
+
+class bit_reader {
+public:
+  bit_reader(const uint8_t* p, size_t n) : p_(p), n_(n), pos_(0) {}
+  // read n bits (n <= 64), most significant first
+  uint64_t get(int n){
+    uint64_t v = 0;
+    while(n > 0){
+      size_t byte = pos_ >> 3;
+      if(byte >= n_) throw std::runtime_error("trajcodec: truncated block");
+      int avail = 8 - int(pos_ & 7);
+      int take = n < avail ? n : avail;
+      uint64_t bits = (p_[byte] >> (avail - take)) & ((1U << take) - 1);
+      v = (v << take) | bits;
+      pos_ += take;
+      n -= take;
+    }
+    return v;
+  }
+private:
+  const uint8_t* p_;
+  size_t n_;
+  size_t pos_;
+};
+
+//---- Gorilla XOR ----//
+
+inline void gorilla_encode(const double* x, size_t n, std::vector<uint8_t>& out){
+  bit_writer w(out);
+  if(n == 0) return;
+  uint64_t prev = bits_of(x[0]);
+  w.put(prev, 64);
+  int prev_lz = -1, prev_tz = 0;
+  for(size_t i = 1; i < n; ++i){
+    uint64_t cur = bits_of(x[i]);
+    uint64_t d = cur ^ prev;
+    prev = cur;
+    if(d == 0){
+      w.put(0, 1);
+      continue;
+    }
+    int lz = clz64(d);
+    int tz = ctz64(d);
+    if(lz > 31) lz = 31;
+    if(prev_lz >= 0 && lz >= prev_lz && tz >= prev_tz){
+      // fits in the previous window of meaningful bits
+      w.put(2, 2);
+      w.put(d >> prev_tz, 64 - prev_lz - prev_tz);
+    } else {
+      int len = 64 - lz - tz;
+      w.put(3, 2);
+      w.put(uint64_t(lz), 5);
+      w.put(uint64_t(len - 1), 6);
+      w.put(d >> tz, len);
+      prev_lz = lz;
+      prev_tz = tz;
+    }
+  }
+  w.flush();
+}
+
+inline void gorilla_decode(const uint8_t* p, size_t nbytes, double* x, size_t n){
+  if(n == 0) return;
+  bit_reader r(p, nbytes);
+  uint64_t prev = r.get(64);
+  x[0] = double_of(prev);
+  int prev_lz = 0, prev_tz = 0;
+  for(size_t i = 1; i < n; ++i){
+    if(r.get(1) == 1){
+      if(r.get(1) == 1){
+        prev_lz = int(r.get(5));
+        int len = int(r.get(6)) + 1;
+        prev_tz = 64 - prev_lz - len;
+      }
+      prev ^= r.get(64 - prev_lz - prev_tz) << prev_tz;
+    }
+    x[i] = double_of(prev);
+  }
+}
+
+//---- delta + byte shuffle + zero runs ----//
+
+// tokens: t < 128 -> t + 1 literal bytes follow; t >= 128 -> t - 127 zero bytes
+inline void zrle_encode(const uint8_t* p, size_t n, std::vector<uint8_t>& out){
+  size_t i = 0;
+  while(i < n){
+    size_t j = i;
+    while(j < n && p[j] == 0 && j - i < 128) ++j;
+    if(j - i >= 2 || (j > i && j == n)){
+      out.push_back(uint8_t(127 + (j - i)));
+      i = j;
+      continue;
+    }
+    // literal run until the next pair of zeros
+    j = i;
+    while(j < n && j - i < 128 && !(p[j] == 0 && j + 1 < n && p[j + 1] == 0)) ++j;
+    out.push_back(uint8_t(j - i - 1));
+    out.insert(out.end(), p + i, p + j);
+    i = j;
+  }
+}
+
+inline void zrle_decode(const uint8_t* p, size_t nbytes, uint8_t* out, size_t n){
+  size_t i = 0, k = 0;
+  while(k < n){
+    if(i >= nbytes) throw std::runtime_error("trajcodec: truncated block");
+    uint8_t t = p[i++];
+    if(t >= 128){
+      size_t run = t - 127;
+      if(k + run > n) throw std::runtime_error("trajcodec: corrupt block");
+      std::memset(out + k, 0, run);
+      k += run;
+    } else {
+      size_t run = size_t(t) + 1;
+      if(k + run > n || i + run > nbytes) throw std::runtime_error("trajcodec: corrupt block");
+      std::memcpy(out + k, p + i, run);
+      i += run;
+      k += run;
+    }
+  }
+}
+
+// scratch: reused between calls to avoid allocating per column
+inline void shuffle_encode(const double* x, size_t n, std::vector<uint8_t>& out, std::vector<uint8_t>& scratch){
+  scratch.assign(8 * n, 0);
+  uint64_t prev = 0;
+  for(size_t i = 0; i < n; ++i){
+    uint64_t cur = bits_of(x[i]);
+    int64_t d = int64_t(cur - prev);
+    uint64_t z = (uint64_t(d) << 1) ^ uint64_t(d >> 63);
+    prev = cur;
+    for(int b = 0; b < 8; ++b) scratch[size_t(b) * n + i] = uint8_t(z >> (8 * b));
+  }
+  zrle_encode(scratch.data(), scratch.size(), out);
+}
+
+inline void shuffle_decode(const uint8_t* p, size_t nbytes, double* x, size_t n, std::vector<uint8_t>& scratch){
+  scratch.assign(8 * n, 0);
+  zrle_decode(p, nbytes, scratch.data(), scratch.size());
+  uint64_t prev = 0;
+  for(size_t i = 0; i < n; ++i){
+    uint64_t z = 0;
+    for(int b = 0; b < 8; ++b) z |= uint64_t(scratch[size_t(b) * n + i]) << (8 * b);
+    uint64_t d = (z >> 1) ^ (~(z & 1) + 1);
+    prev += d;
+    x[i] = double_of(prev);
+  }
+}
+
+//---- blocks ----//
+
+inline void put_u32(std::vector<uint8_t>& out, uint32_t v){
+  for(int b = 0; b < 4; ++b) out.push_back(uint8_t(v >> (8 * b)));
+}
+
+inline uint32_t get_u32(const uint8_t* p){
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// block layout: nrow (u32), ncol (u32), then per column: method (u8), nbytes (u32), payload
+// x: column-major nrow x ncol
+inline void encode_block(const double* x, uint32_t nrow, uint32_t ncol, std::vector<uint8_t>& out,
+                         std::vector<uint8_t>& col_a, std::vector<uint8_t>& col_b, std::vector<uint8_t>& scratch){
+  put_u32(out, nrow);
+  put_u32(out, ncol);
+  for(uint32_t j = 0; j < ncol; ++j){
+    const double* col = x + size_t(j) * nrow;
+    col_a.clear();
+    col_b.clear();
+    gorilla_encode(col, nrow, col_a);
+    shuffle_encode(col, nrow, col_b, scratch);
+    bool g = col_a.size() <= col_b.size();
+    const std::vector<uint8_t>& best = g ? col_a : col_b;
+    out.push_back(g ? GORILLA : SHUFFLE);
+    put_u32(out, uint32_t(best.size()));
+    out.insert(out.end(), best.begin(), best.end());
+  }
+}
+
+inline void block_dim(const uint8_t* p, size_t nbytes, uint32_t& nrow, uint32_t& ncol){
+  if(nbytes < 8) throw std::runtime_error("trajcodec: truncated block");
+  nrow = get_u32(p);
+  ncol = get_u32(p + 4);
+}
+
+// x: preallocated nrow x ncol, column-major
+inline void decode_block(const uint8_t* p, size_t nbytes, double* x, std::vector<uint8_t>& scratch){
+  uint32_t nrow, ncol;
+  block_dim(p, nbytes, nrow, ncol);
+  size_t pos = 8;
+  for(uint32_t j = 0; j < ncol; ++j){
+    if(pos + 5 > nbytes) throw std::runtime_error("trajcodec: truncated block");
+    uint8_t m = p[pos];
+    uint32_t len = get_u32(p + pos + 1);
+    pos += 5;
+    if(pos + len > nbytes) throw std::runtime_error("trajcodec: truncated block");
+    double* col = x + size_t(j) * nrow;
+    if(m == GORILLA) gorilla_decode(p + pos, len, col, nrow);
+    else if(m == SHUFFLE) shuffle_decode(p + pos, len, col, nrow, scratch);
+    else throw std::runtime_error("trajcodec: unknown column method");
+    pos += len;
+  }
+}
+
+} // namespace trajcodec
+
+#endif // TRAJCODEC_H